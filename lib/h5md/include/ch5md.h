@@ -54,15 +54,26 @@ typedef struct {
 } h5md_file;
 
 h5md_file h5md_create_file (const char *filename, const char *author, const char *author_email, const char *creator, const char *creator_version);
+h5md_file h5md_create_file_faccess (const char *filename, const char *author, const char *author_email, const char *creator, const char *creator_version, hid_t faccess);
 int h5md_close_file(h5md_file file);
 hid_t h5md_open_file (const char *filename);
 h5md_particles_group h5md_create_particles_group(h5md_file file, const char *name);
 hid_t h5md_open_particles_group(hid_t particles, const char *name);
+void h5md_set_chunk_bytes(size_t bytes);
+void h5md_set_deflate(int level);
 h5md_element h5md_create_time_data(hid_t loc, const char *name, int rank, int int_dims[], hid_t datatype, h5md_element *link);
 int h5md_close_element(h5md_element e);
 h5md_element h5md_create_fixed_data_simple(hid_t loc, const char *name, int rank, int int_dims[], hid_t datatype, void *data);
+h5md_element h5md_create_fixed_data_strided(hid_t loc, const char *name, int rank, int int_dims[], hid_t datatype, hid_t mem_type, void *data, int mem_offset, int mem_stride);
 h5md_element h5md_create_fixed_data_scalar(hid_t loc, const char *name, hid_t datatype, void *data);
 int h5md_append(h5md_element e, void *data, int step, double time);
+int h5md_append_coll(h5md_element e, void *data, int step, double time,
+    int do_write);
+int h5md_extend_frame(h5md_element e, int step, double time);
+int h5md_extend_frame_coll(h5md_element e, int step, double time,
+    int do_write);
+int h5md_append_chunk(h5md_element e, void *data, hid_t mem_type,
+    int part_start, int part_count, int mem_offset, int mem_stride);
 int h5md_create_box(h5md_particles_group *group, int dim, char *boundary[], bool is_time, double value[], h5md_element *link);
 int h5md_write_string_attribute(hid_t loc, const char *obj_name,
     const char *att_name, const char *value);
@@ -15,7 +15,36 @@
 #define MAX_CHUNK 256
 #define MAX_RANK 5
 
+// Target size in bytes for the chunks of newly created time-dependent
+// datasets. Zero selects the legacy element-count heuristic. On striped
+// parallel filesystems (Lustre, GPFS) this should be set to the stripe
+// size so that each chunk maps to one stripe-aligned transfer.
+static size_t target_chunk_bytes = 0;
+
+void h5md_set_chunk_bytes(size_t bytes)
+{
+  target_chunk_bytes = bytes;
+}
+
+// Deflate level (0-9, 0 disables) applied to the value datasets of
+// newly created time-dependent elements, preceded by the byte-shuffle
+// filter which greatly improves deflate ratios on floating-point data.
+static int deflate_level = 0;
+
+void h5md_set_deflate(int level)
+{
+  deflate_level = level;
+}
+
 h5md_file h5md_create_file (const char *filename, const char *author, const char *author_email, const char *creator, const char *creator_version)
+{
+  return h5md_create_file_faccess(filename, author, author_email, creator,
+                                  creator_version, H5P_DEFAULT);
+}
+
+// Variant of h5md_create_file taking a file access property list, e.g.
+// to open the file for parallel (MPI-IO) access with H5Pset_fapl_mpio.
+h5md_file h5md_create_file_faccess (const char *filename, const char *author, const char *author_email, const char *creator, const char *creator_version, hid_t faccess)
 {
   h5md_file file;
   hid_t g, g1;
@@ -25,7 +54,7 @@ h5md_file h5md_create_file (const char *filename, const char *author, const char
   file.version[0] = 1;
   file.version[1] = 0;
 
-  file.id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  file.id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, faccess);
   g = H5Gcreate(file.id, "h5md", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
   dims[0] = 2;
@@ -165,7 +194,18 @@ h5md_element h5md_create_time_data(hid_t loc, const char *name, int rank, int in
     max_dims[i+1] = int_dims[i];
   }
   chunks[0] = 1 ;
-  if (MAX_CHUNK<int_dims[0]/4) {
+  if (target_chunk_bytes>0) {
+    // size the chunk so that one frame slab comes close to the
+    // requested byte target
+    size_t row_bytes = H5Tget_size(datatype);
+    hsize_t chunk_rows;
+    for (i=1; i<rank; i++) row_bytes *= int_dims[i];
+    chunk_rows = target_chunk_bytes/row_bytes;
+    if (chunk_rows<1) chunk_rows = 1;
+    if (int_dims[0]>0 && chunk_rows>(hsize_t)int_dims[0])
+      chunk_rows = int_dims[0];
+    chunks[1] = chunk_rows;
+  } else if (MAX_CHUNK<int_dims[0]/4) {
     chunks[1] = MAX_CHUNK;
   } else {
     chunks[1] = int_dims[0];
@@ -177,9 +217,13 @@ h5md_element h5md_create_time_data(hid_t loc, const char *name, int rank, int in
   td.group = H5Gcreate(loc, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
   if (NULL==link) {
+    // with a byte target in effect, batch several frames per chunk of
+    // the small step/time datasets instead of one chunk per frame
+    hsize_t t_chunks[1];
+    t_chunks[0] = (target_chunk_bytes>0) ? 128 : 1;
     spc = H5Screate_simple( 1 , dims, max_dims);
     plist = H5Pcreate(H5P_DATASET_CREATE);
-    H5Pset_chunk(plist, 1, chunks);
+    H5Pset_chunk(plist, 1, t_chunks);
     td.time = H5Dcreate(td.group, "time", H5T_NATIVE_DOUBLE, spc, H5P_DEFAULT, plist, H5P_DEFAULT);
     td.step = H5Dcreate(td.group, "step", H5T_NATIVE_INT, spc, H5P_DEFAULT, plist, H5P_DEFAULT);
     H5Pclose(plist);
@@ -194,6 +238,10 @@ h5md_element h5md_create_time_data(hid_t loc, const char *name, int rank, int in
   spc = H5Screate_simple( rank+1 , dims, max_dims) ;
   plist = H5Pcreate(H5P_DATASET_CREATE);
   H5Pset_chunk(plist, rank+1, chunks);
+  if (deflate_level>0) {
+    H5Pset_shuffle(plist);
+    H5Pset_deflate(plist, deflate_level);
+  }
   td.value = H5Dcreate(td.group, "value", datatype, spc, H5P_DEFAULT, plist, H5P_DEFAULT);
   H5Pclose(plist);
   H5Sclose(spc);
@@ -246,6 +294,47 @@ h5md_element h5md_create_fixed_data_simple(hid_t loc, const char *name, int rank
 
 }
 
+// Variant of h5md_create_fixed_data_simple that reads the data from an
+// interleaved buffer of mem_type elements: row i of the dataset starts
+// at data[mem_offset + i*mem_stride] and holds int_dims[1] (or one, for
+// rank 1) consecutive values. HDF5 converts mem_type to datatype.
+h5md_element h5md_create_fixed_data_strided(hid_t loc, const char *name, int rank, int int_dims[], hid_t datatype, hid_t mem_type, void *data, int mem_offset, int mem_stride)
+{
+
+  h5md_element fd;
+
+  hid_t spc, mem_spc;
+  hsize_t dims[H5S_MAX_RANK];
+  hsize_t mem_dims[1], start[1], stride[1], count[1], block[1];
+  int i;
+
+  memset(&fd,0,sizeof(fd));
+  for (i=0; i<rank; i++) {
+    dims[i] = int_dims[i];
+  }
+
+  spc = H5Screate_simple(rank, dims, NULL);
+  fd.value = H5Dcreate(loc, name, datatype, spc, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Sclose(spc);
+
+  mem_dims[0] = mem_offset + (hsize_t) int_dims[0]*mem_stride;
+  mem_spc = H5Screate_simple(1, mem_dims, NULL);
+  start[0] = mem_offset;
+  stride[0] = mem_stride;
+  count[0] = int_dims[0];
+  block[0] = (rank>1) ? int_dims[1] : 1;
+  H5Sselect_hyperslab(mem_spc, H5S_SELECT_SET, start, stride, count, block);
+
+  H5Dwrite(fd.value, mem_type, mem_spc, H5S_ALL, H5P_DEFAULT, data);
+  H5Sclose(mem_spc);
+  H5Dclose(fd.value);
+
+  fd.is_time = false;
+
+  return fd;
+
+}
+
 h5md_element h5md_create_fixed_data_scalar(hid_t loc, const char *name, hid_t datatype, void *data)
 {
 
@@ -288,7 +377,18 @@ int h5md_extend_by_one(hid_t dset, hsize_t *dims) {
 
 }
 
-int h5md_append(h5md_element e, void *data, int step, double time) {
+// Extend a time-dependent element by one frame and record its step and
+// time, without writing any of the frame's data. Use together with
+// h5md_append_chunk to fill the frame in several pieces.
+int h5md_extend_frame(h5md_element e, int step, double time) {
+  return h5md_extend_frame_coll(e, step, time, 1);
+}
+
+// Variant of h5md_extend_frame for parallel HDF5: H5Dset_extent is a
+// collective operation, so every rank must call this, but only one rank
+// (do_write true) writes the step and time values.
+int h5md_extend_frame_coll(h5md_element e, int step, double time,
+    int do_write) {
 
   hid_t mem_space, file_space;
   int i, rank;
@@ -301,54 +401,76 @@ int h5md_append(h5md_element e, void *data, int step, double time) {
   if (NULL==e.link) {
     h5md_extend_by_one(e.step, dims);
 
-    // Define hyperslab selection
-    start[0] = dims[0]-1;
-    count[0] = 1;
-
-    // Select the hyperslab
-    file_space = H5Dget_space(e.step);
-    rank = H5Sget_simple_extent_ndims(file_space);
-    mem_space = H5Screate_simple(rank-1, dims+1, NULL);
-    // Define hyperslab selection
-    start[0] = dims[0]-1;
-    count[0] = 1;
-    for (i=1 ; i<rank ; i++) {
-      start[i] = 0;
-      count[i] = dims[i];
+    if (do_write) {
+      // Select the hyperslab
+      file_space = H5Dget_space(e.step);
+      rank = H5Sget_simple_extent_ndims(file_space);
+      mem_space = H5Screate_simple(rank-1, dims+1, NULL);
+      // Define hyperslab selection
+      start[0] = dims[0]-1;
+      count[0] = 1;
+      for (i=1 ; i<rank ; i++) {
+        start[i] = 0;
+        count[i] = dims[i];
+      }
+      H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+      H5Dwrite(e.step, H5T_NATIVE_INT, mem_space, file_space, H5P_DEFAULT, (void *)&step);
+      H5Sclose(file_space);
+      H5Sclose(mem_space);
     }
-    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-    H5Dwrite(e.step, H5T_NATIVE_INT, mem_space, file_space, H5P_DEFAULT, (void *)&step);
-    H5Sclose(file_space);
-    H5Sclose(mem_space);
 
     h5md_extend_by_one(e.time, dims);
 
-    // Define hyperslab selection
-    start[0] = dims[0]-1;
-    count[0] = 1;
-
-    // Select the hyperslab
-    file_space = H5Dget_space(e.time);
-    rank = H5Sget_simple_extent_ndims(file_space);
-    mem_space = H5Screate_simple(rank-1, dims+1, NULL);
-    // Define hyperslab selection
-    start[0] = dims[0]-1;
-    count[0] = 1;
-    for (i=1 ; i<rank ; i++) {
-      start[i] = 0;
-      count[i] = dims[i];
+    if (do_write) {
+      // Select the hyperslab
+      file_space = H5Dget_space(e.time);
+      rank = H5Sget_simple_extent_ndims(file_space);
+      mem_space = H5Screate_simple(rank-1, dims+1, NULL);
+      // Define hyperslab selection
+      start[0] = dims[0]-1;
+      count[0] = 1;
+      for (i=1 ; i<rank ; i++) {
+        start[i] = 0;
+        count[i] = dims[i];
+      }
+      H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+      H5Dwrite(e.time, H5T_NATIVE_DOUBLE, mem_space, file_space, H5P_DEFAULT, (void *)&time);
+      H5Sclose(file_space);
+      H5Sclose(mem_space);
     }
-    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-    H5Dwrite(e.time, H5T_NATIVE_DOUBLE, mem_space, file_space, H5P_DEFAULT, (void *)&time);
-    H5Sclose(file_space);
-    H5Sclose(mem_space);
   }
 
   h5md_extend_by_one(e.value, dims);
 
+  return 0;
+}
+
+int h5md_append(h5md_element e, void *data, int step, double time) {
+  return h5md_append_coll(e, data, step, time, 1);
+}
+
+// Variant of h5md_append for parallel HDF5: every rank participates in
+// the collective dataset extension, only one rank (do_write true)
+// writes the data.
+int h5md_append_coll(h5md_element e, void *data, int step, double time,
+    int do_write) {
+
+  hid_t mem_space, file_space;
+  int i, rank;
+  hsize_t dims[H5S_MAX_RANK];
+  hsize_t start[H5S_MAX_RANK], count[H5S_MAX_RANK];
+
+  // If not a time-dependent H5MD element, do nothing
+  if (!e.is_time) return 0;
+
+  h5md_extend_frame_coll(e, step, time, do_write);
+
+  if (!do_write) return 0;
+
   // Select the hyperslab
   file_space = H5Dget_space(e.value);
   rank = H5Sget_simple_extent_ndims(file_space);
+  H5Sget_simple_extent_dims(file_space, dims, NULL);
   mem_space = H5Screate_simple(rank-1, dims+1, NULL);
 
   // Define hyperslab selection
@@ -366,6 +488,57 @@ int h5md_append(h5md_element e, void *data, int step, double time) {
   return 0;
 }
 
+// Write the particle range [part_start, part_start+part_count) of the
+// most recent frame of a time-dependent element. The data is read from
+// an interleaved buffer of mem_type items in which the record of one
+// particle starts mem_offset items into its row and rows are mem_stride
+// items apart, as in the row-per-atom pack buffers of simulation codes.
+// The strided memory selection lets HDF5 write straight from such a
+// buffer without an intermediate contiguous copy.
+int h5md_append_chunk(h5md_element e, void *data, hid_t mem_type,
+    int part_start, int part_count, int mem_offset, int mem_stride) {
+
+  hid_t mem_space, file_space;
+  int i, rank;
+  hsize_t dims[H5S_MAX_RANK];
+  hsize_t start[H5S_MAX_RANK], count[H5S_MAX_RANK];
+  hsize_t mem_dims[1], mem_start[1], mem_str[1], mem_count[1], mem_block[1];
+
+  // If not a time-dependent H5MD element, do nothing
+  if (!e.is_time) return 0;
+  if (part_count<=0) return 0;
+
+  // Select the particle range within the last frame
+  file_space = H5Dget_space(e.value);
+  rank = H5Sget_simple_extent_ndims(file_space);
+  H5Sget_simple_extent_dims(file_space, dims, NULL);
+  start[0] = dims[0]-1;
+  count[0] = 1;
+  start[1] = part_start;
+  count[1] = part_count;
+  for (i=2 ; i<rank ; i++) {
+    start[i] = 0;
+    count[i] = dims[i];
+  }
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+
+  // Select the matching records in the interleaved source buffer
+  mem_dims[0] = (hsize_t)mem_offset + (hsize_t)part_count*mem_stride;
+  mem_space = H5Screate_simple(1, mem_dims, NULL);
+  mem_start[0] = mem_offset;
+  mem_str[0] = mem_stride;
+  mem_count[0] = part_count;
+  mem_block[0] = (rank>2) ? dims[2] : 1;
+  H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, mem_start, mem_str,
+                      mem_count, mem_block);
+
+  H5Dwrite(e.value, mem_type, mem_space, file_space, H5P_DEFAULT, data);
+  H5Sclose(file_space);
+  H5Sclose(mem_space);
+
+  return 0;
+}
+
 int h5md_create_box(h5md_particles_group *group, int dim, char *boundary[], bool is_time, double value[], h5md_element *link)
 {
   hid_t spc, att, t;
@@ -37,6 +37,20 @@ using namespace LAMMPS_NS;
 #define MYMIN(a,b) ((a) < (b) ? (a) : (b))
 #define MYMAX(a,b) ((a) > (b) ? (a) : (b))
 
+// optional parallel output: compile with -DLMP_H5MD_PARALLEL and a
+// parallel (MPI) build of HDF5. every rank then opens the file through
+// MPI-IO and writes its own rows of each frame in place, instead of
+// funneling all data through rank 0.
+
+#ifdef LMP_H5MD_PARALLEL
+#if !defined(H5_HAVE_PARALLEL)
+#error "LMP_H5MD_PARALLEL requires a parallel (MPI) build of HDF5"
+#endif
+#define H5MD_ALL_RANKS 1
+#else
+#define H5MD_ALL_RANKS 0
+#endif
+
 /** Scan common options for the dump elements
  */
 static int element_args(int narg, char **arg, int *every)
@@ -73,6 +87,8 @@ DumpH5MD::DumpH5MD(LAMMPS *lmp, int narg, char **arg) : Dump(lmp, narg, arg)
   unwrap_flag = 0;
   datafile_from_dump = -1;
   author_name=NULL;
+  align_bytes = 0;
+  deflate_level = 0;
 
   every_dump = force->inumeric(FLERR,arg[3]);
   every_position = every_image = -1;
@@ -182,31 +198,70 @@ DumpH5MD::DumpH5MD(LAMMPS *lmp, int narg, char **arg) : Dump(lmp, narg, arg)
 	error->all(FLERR, "Illegal dump h5md command: author argument repeated");
       }
       iarg+=2;
+    } else if (strcmp(arg[iarg], "align")==0) {
+      if (iarg+1>=narg) {
+        error->all(FLERR, "Invalid number of arguments in dump h5md");
+      }
+      align_bytes = force->inumeric(FLERR,arg[iarg+1]);
+      if (align_bytes<0)
+	error->all(FLERR, "Illegal dump h5md command");
+      iarg+=2;
+    } else if (strcmp(arg[iarg], "compress")==0) {
+      if (iarg+1>=narg) {
+        error->all(FLERR, "Invalid number of arguments in dump h5md");
+      }
+      deflate_level = force->inumeric(FLERR,arg[iarg+1]);
+      if (deflate_level<0 || deflate_level>9)
+	error->all(FLERR, "Illegal dump h5md command");
+      iarg+=2;
     } else {
       error->all(FLERR, "Invalid argument to dump h5md");
     }
   }
 
-  // allocate global array for atom coords
+#ifdef LMP_H5MD_PARALLEL
+  // each rank writes its own rows of every frame, so make every rank a
+  // file writer with a one-proc cluster. fixed-in-time elements are
+  // written in one shot from a full staging array and are not supported
+  // in this mode.
+
+  nclusterprocs = 1;
+  filewriter = 1;
+  fileproc = me;
+
+  if (every_dump==0 || every_position==0 || every_image==0 ||
+      every_velocity==0 || every_force==0 || every_species==0 ||
+      every_charge==0)
+    error->all(FLERR,
+               "Dump h5md parallel output requires time-dependent elements");
+
+  // HDF5 cannot write filtered (compressed) datasets through
+  // independent parallel I/O, which is what this mode uses
+
+  if (deflate_level>0)
+    error->all(FLERR,
+               "Dump h5md parallel output does not support compression");
+#endif
+
+  // fixed-in-time (every = 0) elements are staged in one packed block
+  // laid out like the pack buffer, so all fields share one allocation.
+  // time-dependent elements are written to the file directly from the
+  // sorted pack buffer and need no staging at all.
 
   bigint n = group->count(igroup);
   natoms = static_cast<int> (n);
 
-  if (every_position>=0)
-    memory->create(dump_position,domain->dimension*natoms,"dump:position");
-  if (every_image>=0)
-    memory->create(dump_image,domain->dimension*natoms,"dump:image");
-  if (every_velocity>=0)
-    memory->create(dump_velocity,domain->dimension*natoms,"dump:velocity");
-  if (every_force>=0)
-    memory->create(dump_force,domain->dimension*natoms,"dump:force");
-  if (every_species>=0)
-    memory->create(dump_species,natoms,"dump:species");
-  if (every_charge>=0)
-    memory->create(dump_charge,natoms,"dump:charge");
+  dump_fixed = NULL;
+  if (every_position==0 || every_image==0 || every_velocity==0 ||
+      every_force==0 || every_species==0 || every_charge==0)
+    memory->create(dump_fixed,natoms*size_one,"dump:fixed");
+
+  nchoose = maxlocal = 0;
+  clist = NULL;
 
   openfile();
   ntotal = 0;
+  frame_extended = false;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -214,34 +269,25 @@ DumpH5MD::DumpH5MD(LAMMPS *lmp, int narg, char **arg) : Dump(lmp, narg, arg)
 DumpH5MD::~DumpH5MD()
 {
   if (every_position>=0) {
-    memory->destroy(dump_position);
-    if (me==0) {
+    if (me==0 || H5MD_ALL_RANKS) {
       h5md_close_element(particles_data.position);
       if (do_box)
 	h5md_close_element(particles_data.box_edges);
     }
   }
-  if (every_image>=0) {
-    memory->destroy(dump_image);
-    if (me==0) h5md_close_element(particles_data.image);
-  }
-  if (every_velocity>=0) {
-    memory->destroy(dump_velocity);
-    if (me==0) h5md_close_element(particles_data.velocity);
-  }
-  if (every_force>=0) {
-    memory->destroy(dump_force);
-    if (me==0) h5md_close_element(particles_data.force);
-  }
-  if (every_species>=0) {
-    memory->destroy(dump_species);
-    if (me==0) h5md_close_element(particles_data.species);
-  }
-  if (every_charge>=0) {
-    memory->destroy(dump_charge);
-    if (me==0) h5md_close_element(particles_data.charge);
-  }
-
+  if (every_image>=0 && (me==0 || H5MD_ALL_RANKS))
+    h5md_close_element(particles_data.image);
+  if (every_velocity>=0 && (me==0 || H5MD_ALL_RANKS))
+    h5md_close_element(particles_data.velocity);
+  if (every_force>=0 && (me==0 || H5MD_ALL_RANKS))
+    h5md_close_element(particles_data.force);
+  if (every_species>=0 && (me==0 || H5MD_ALL_RANKS))
+    h5md_close_element(particles_data.species);
+  if (every_charge>=0 && (me==0 || H5MD_ALL_RANKS))
+    h5md_close_element(particles_data.charge);
+
+  memory->destroy(dump_fixed);
+  memory->destroy(clist);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -269,13 +315,39 @@ void DumpH5MD::openfile()
     }
   }
 
-  if (me == 0) {
+  if (me == 0 || H5MD_ALL_RANKS) {
+    // size dataset chunks to the requested alignment (e.g. the Lustre
+    // stripe size) so each chunk maps onto one stripe-aligned transfer
+    h5md_set_chunk_bytes(align_bytes);
+    // apply shuffle + gzip filters to the trajectory datasets
+    h5md_set_deflate(deflate_level);
     if (datafile_from_dump<0) {
+      hid_t faccess = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef LMP_H5MD_PARALLEL
+      H5Pset_fapl_mpio(faccess, world, MPI_INFO_NULL);
+#endif
+      if (align_bytes>0)
+	H5Pset_alignment(faccess, 1, align_bytes);
+
+      // the dump blocks the timestep for as long as H5Dwrite runs, so
+      // cut the time spent inside the library: aggregate metadata into
+      // large blocks, coalesce small raw-data accesses through a big
+      // sieve buffer, and size the chunk cache to hold a whole dataset
+      // chunk so chunked (and compressed) frames are filtered and
+      // evicted once instead of being rewritten per partial access
+
+      size_t iobuf = 4194304;
+      if ((size_t)align_bytes > iobuf) iobuf = align_bytes;
+      H5Pset_meta_block_size(faccess, 1048576);
+      H5Pset_sieve_buf_size(faccess, iobuf);
+      H5Pset_cache(faccess, 0, 521, 2*iobuf, 0.75);
+
       if (author_name==NULL) {
-	datafile = h5md_create_file(filename, "N/A", NULL, "lammps", LAMMPS_VERSION);
+	datafile = h5md_create_file_faccess(filename, "N/A", NULL, "lammps", LAMMPS_VERSION, faccess);
       } else {
-	datafile = h5md_create_file(filename, author_name, NULL, "lammps", LAMMPS_VERSION);
+	datafile = h5md_create_file_faccess(filename, author_name, NULL, "lammps", LAMMPS_VERSION, faccess);
       }
+      H5Pclose(faccess);
       group_name_length = strlen(group->names[igroup])+1;
       group_name = new char[group_name_length];
       strcpy(group_name, group->names[igroup]);
@@ -355,7 +427,21 @@ void DumpH5MD::write_header(bigint nbig)
 
 void DumpH5MD::pack(tagint *ids)
 {
-  int m,n;
+  // the spatial dimension is fixed for the whole run: dispatch once to
+  // an instantiation with DIM as a compile-time constant, so the
+  // three-component copies below carry no per-atom branch and unroll
+
+  if (domain->dimension == 3) pack_impl<3>(ids);
+  else pack_impl<2>(ids);
+}
+
+/* ---------------------------------------------------------------------- */
+
+template <int DIM>
+void DumpH5MD::pack_impl(tagint *ids)
+{
+  int i,m,n;
+  double *b;
 
   tagint *tag = atom->tag;
   double **x = atom->x;
@@ -366,101 +452,212 @@ void DumpH5MD::pack(tagint *ids)
   imageint *image = atom->image;
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
-  int dim=domain->dimension;
 
   double xprd = domain->xprd;
   double yprd = domain->yprd;
   double zprd = domain->zprd;
 
-  m = n = 0;
-  for (int i = 0; i < nlocal; i++)
-    if (mask[i] & groupbit) {
-      if (every_position>=0) {
+  // collect the local atoms of the dump group once, so that the
+  // per-field loops below run branch-free over a dense index list
+
+  if (nlocal > maxlocal) {
+    maxlocal = atom->nmax;
+    memory->destroy(clist);
+    memory->create(clist,maxlocal,"dump:clist");
+  }
+  nchoose = 0;
+  for (i = 0; i < nlocal; i++)
+    if (mask[i] & groupbit) clist[nchoose++] = i;
+
+  // one pass per dumped field: a field-major traversal touches one
+  // per-atom array at a time instead of re-testing every field flag
+  // for every atom
+
+  m = 0;
+  if (every_position>=0) {
+    b = &buf[m];
+    if (unwrap_flag == 1) {
+      for (n = 0; n < nchoose; n++) {
+	i = clist[n];
 	int ix = (image[i] & IMGMASK) - IMGMAX;
 	int iy = (image[i] >> IMGBITS & IMGMASK) - IMGMAX;
 	int iz = (image[i] >> IMG2BITS) - IMGMAX;
-	if (unwrap_flag == 1) {
-	  buf[m++] = (x[i][0] + ix * xprd);
-	  buf[m++] = (x[i][1] + iy * yprd);
-	  if (dim>2) buf[m++] = (x[i][2] + iz * zprd);
-	} else {
-	  buf[m++] = x[i][0];
-	  buf[m++] = x[i][1];
-	  if (dim>2) buf[m++] = x[i][2];
-	}
-	if (every_image>=0) {
-	  buf[m++] = ix;
-	  buf[m++] = iy;
-	  if (dim>2) buf[m++] = iz;
-	}
+	b[0] = (x[i][0] + ix * xprd);
+	b[1] = (x[i][1] + iy * yprd);
+	if (DIM>2) b[2] = (x[i][2] + iz * zprd);
+	b += size_one;
       }
-      if (every_velocity>=0) {
-	buf[m++] = v[i][0];
-	buf[m++] = v[i][1];
-	if (dim>2) buf[m++] = v[i][2];
+    } else {
+      for (n = 0; n < nchoose; n++) {
+	i = clist[n];
+	b[0] = x[i][0];
+	b[1] = x[i][1];
+	if (DIM>2) b[2] = x[i][2];
+	b += size_one;
       }
-      if (every_force>=0) {
-	buf[m++] = f[i][0];
-	buf[m++] = f[i][1];
-	if (dim>2) buf[m++] = f[i][2];
+    }
+    m += DIM;
+    if (every_image>=0) {
+      b = &buf[m];
+      for (n = 0; n < nchoose; n++) {
+	i = clist[n];
+	b[0] = (image[i] & IMGMASK) - IMGMAX;
+	b[1] = (image[i] >> IMGBITS & IMGMASK) - IMGMAX;
+	if (DIM>2) b[2] = (image[i] >> IMG2BITS) - IMGMAX;
+	b += size_one;
       }
-      if (every_species>=0)
-	buf[m++] = species[i];
-      if (every_charge>=0)
-	buf[m++] = q[i];
-      ids[n++] = tag[i];
+      m += DIM;
+    }
+  }
+  if (every_velocity>=0) {
+    b = &buf[m];
+    for (n = 0; n < nchoose; n++) {
+      i = clist[n];
+      b[0] = v[i][0];
+      b[1] = v[i][1];
+      if (DIM>2) b[2] = v[i][2];
+      b += size_one;
+    }
+    m += DIM;
+  }
+  if (every_force>=0) {
+    b = &buf[m];
+    for (n = 0; n < nchoose; n++) {
+      i = clist[n];
+      b[0] = f[i][0];
+      b[1] = f[i][1];
+      if (DIM>2) b[2] = f[i][2];
+      b += size_one;
+    }
+    m += DIM;
+  }
+  if (every_species>=0) {
+    b = &buf[m];
+    for (n = 0; n < nchoose; n++) {
+      b[0] = species[clist[n]];
+      b += size_one;
     }
+    m += 1;
+  }
+  if (every_charge>=0) {
+    b = &buf[m];
+    for (n = 0; n < nchoose; n++) {
+      b[0] = q[clist[n]];
+      b += size_one;
+    }
+    m += 1;
+  }
+
+  for (n = 0; n < nchoose; n++) ids[n] = tag[clist[n]];
 }
 
 /* ---------------------------------------------------------------------- */
 
 void DumpH5MD::write_data(int n, double *mybuf)
 {
-  // copy buf atom coords into global array
-
   int m = 0;
   int dim = domain->dimension;
-  int k = dim*ntotal;
-  int k_image = dim*ntotal;
-  int k_velocity = dim*ntotal;
-  int k_force = dim*ntotal;
-  int k_species = ntotal;
-  int k_charge = ntotal;
-  for (int i = 0; i < n; i++) {
-    if (every_position>=0) {
-      for (int j=0; j<dim; j++) {
-	dump_position[k++] = mybuf[m++];
+
+  if (every_dump>0) {
+
+    // write this chunk of atoms to the file straight from the sorted
+    // pack buffer: each element due at this step gets a strided
+    // hyperslab write selecting its column range in the buffer rows
+
+    int local_step = update->ntimestep;
+    double local_time = local_step * update->dt;
+
+    if (!frame_extended) {
+
+      // first chunk of the snapshot: extend all elements due this step
+
+      if (every_position>0 &&
+          local_step % (every_position*every_dump) == 0) {
+	h5md_extend_frame_coll(particles_data.position, local_step, local_time, me==0);
+	if (every_image>0)
+	  h5md_extend_frame_coll(particles_data.image, local_step, local_time, me==0);
       }
-      if (every_image>=0)
-	for (int j=0; j<dim; j++) {
-	  dump_image[k_image++] = mybuf[m++];
-	}
+      if (every_velocity>0 && local_step % (every_velocity*every_dump) == 0)
+	h5md_extend_frame_coll(particles_data.velocity, local_step, local_time, me==0);
+      if (every_force>0 && local_step % (every_force*every_dump) == 0)
+	h5md_extend_frame_coll(particles_data.force, local_step, local_time, me==0);
+      if (every_species>0 && local_step % (every_species*every_dump) == 0)
+	h5md_extend_frame_coll(particles_data.species, local_step, local_time, me==0);
+      if (every_charge>0 && local_step % (every_charge*every_dump) == 0)
+	h5md_extend_frame_coll(particles_data.charge, local_step, local_time, me==0);
+      frame_extended = true;
     }
-    if (every_velocity>=0)
-      for (int j=0; j<dim; j++) {
-	dump_velocity[k_velocity++] = mybuf[m++];
-      }
-    if (every_force>=0)
-      for (int j=0; j<dim; j++) {
-	dump_force[k_force++] = mybuf[m++];
-      }
-    if (every_species>=0)
-      dump_species[k_species++] = mybuf[m++];
-    if (every_charge>=0)
-      dump_charge[k_charge++] = mybuf[m++];
-    ntotal++;
-  }
 
-  // if last chunk of atoms in this snapshot, write global arrays to file
+    // global row offset of this chunk within the frame. with parallel
+    // output each rank holds one contiguous range of the ID-sorted
+    // frame, located by a prefix sum over the ranks.
+
+    int part_offset = ntotal;
+#ifdef LMP_H5MD_PARALLEL
+    MPI_Scan(&n,&part_offset,1,MPI_INT,MPI_SUM,world);
+    part_offset -= n;
+#endif
+
+    if (every_position>=0) {
+      if (every_position>0 && local_step % (every_position*every_dump) == 0) {
+	h5md_append_chunk(particles_data.position, mybuf, H5T_NATIVE_DOUBLE,
+                          part_offset, n, m, size_one);
+	if (every_image>0)
+	  h5md_append_chunk(particles_data.image, mybuf, H5T_NATIVE_DOUBLE,
+                            part_offset, n, m+dim, size_one);
+      }
+      m += dim;
+      if (every_image>=0) m += dim;
+    }
+    if (every_velocity>=0) {
+      if (every_velocity>0 && local_step % (every_velocity*every_dump) == 0)
+	h5md_append_chunk(particles_data.velocity, mybuf, H5T_NATIVE_DOUBLE,
+                          part_offset, n, m, size_one);
+      m += dim;
+    }
+    if (every_force>=0) {
+      if (every_force>0 && local_step % (every_force*every_dump) == 0)
+	h5md_append_chunk(particles_data.force, mybuf, H5T_NATIVE_DOUBLE,
+                          part_offset, n, m, size_one);
+      m += dim;
+    }
+    if (every_species>=0) {
+      if (every_species>0 && local_step % (every_species*every_dump) == 0)
+	h5md_append_chunk(particles_data.species, mybuf, H5T_NATIVE_DOUBLE,
+                          part_offset, n, m, size_one);
+      m += 1;
+    }
+    if (every_charge>=0) {
+      if (every_charge>0 && local_step % (every_charge*every_dump) == 0)
+	h5md_append_chunk(particles_data.charge, mybuf, H5T_NATIVE_DOUBLE,
+                          part_offset, n, m, size_one);
+      m += 1;
+    }
 
-  if (ntotal == natoms) {
-    if (every_dump>0) {
+    ntotal += n;
+#ifdef LMP_H5MD_PARALLEL
+    // with parallel output write_data runs exactly once per snapshot
+    // and rank, holding just this rank's share of the frame
+    ntotal = natoms;
+#endif
+    if (ntotal == natoms) {
       write_frame();
       ntotal = 0;
-    } else {
-      write_fixed_frame();
+      frame_extended = false;
     }
+    return;
   }
+
+  // fixed-in-time data: this path only runs for every_dump = 0, where
+  // all elements are fixed and each buf row is fully consumed. stage
+  // the rows into the packed block as they arrive and create the
+  // datasets once the last chunk is in.
+
+  memcpy(dump_fixed + (size_t)ntotal*size_one, mybuf,
+         (size_t)n*size_one*sizeof(double));
+  ntotal += n;
+
+  if (ntotal == natoms) write_fixed_frame();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -481,6 +678,9 @@ int DumpH5MD::modify_param(int narg, char **arg)
 
 void DumpH5MD::write_frame()
 {
+  // the per-atom data of this snapshot was already written chunk by
+  // chunk in write_data(); only the box edges remain
+
   int local_step;
   double local_time;
   double edges[3];
@@ -490,26 +690,10 @@ void DumpH5MD::write_frame()
   edges[1] = boxyhi - boxylo;
   edges[2] = boxzhi - boxzlo;
   if (every_position>0) {
-    if (local_step % (every_position*every_dump) == 0) {
-      h5md_append(particles_data.position, dump_position, local_step, local_time);
-      h5md_append(particles_data.box_edges, edges, local_step, local_time);
-      if (every_image>0)
-	h5md_append(particles_data.image, dump_image, local_step, local_time);
-    }
+    if (local_step % (every_position*every_dump) == 0)
+      h5md_append_coll(particles_data.box_edges, edges, local_step, local_time, me==0);
   } else {
-    if (do_box) h5md_append(particles_data.box_edges, edges, local_step, local_time);
-  }
-  if (every_velocity>0 && local_step % (every_velocity*every_dump) == 0) {
-    h5md_append(particles_data.velocity, dump_velocity, local_step, local_time);
-  }
-  if (every_force>0 && local_step % (every_force*every_dump) == 0) {
-    h5md_append(particles_data.force, dump_force, local_step, local_time);
-  }
-  if (every_species>0 && local_step % (every_species*every_dump) == 0) {
-    h5md_append(particles_data.species, dump_species, local_step, local_time);
-  }
-  if (every_charge>0 && local_step % (every_charge*every_dump) == 0) {
-    h5md_append(particles_data.charge, dump_charge, local_step, local_time);
+    if (do_box) h5md_append_coll(particles_data.box_edges, edges, local_step, local_time, me==0);
   }
 }
 
@@ -534,21 +718,44 @@ void DumpH5MD::write_fixed_frame()
   edges[0] = boxxhi - boxxlo;
   edges[1] = boxyhi - boxylo;
   edges[2] = boxzhi - boxzlo;
-  if (every_position==0) {
-    particles_data.position = h5md_create_fixed_data_simple(particles_data.group, "position", 2, dims, H5T_NATIVE_DOUBLE, dump_position);
-    h5md_create_box(&particles_data, dims[1], boundary, false, edges, NULL);
-    if (every_image==0)
-      particles_data.image = h5md_create_fixed_data_simple(particles_data.group, "image", 2, dims, H5T_NATIVE_INT, dump_image);
+
+  // each dataset is written straight from its column range of the
+  // packed staging block; HDF5 converts to the integer sets on the fly
+
+  int m = 0;
+  if (every_position>=0) {
+    if (every_position==0) {
+      particles_data.position = h5md_create_fixed_data_strided(particles_data.group, "position", 2, dims, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, dump_fixed, m, size_one);
+      h5md_create_box(&particles_data, dims[1], boundary, false, edges, NULL);
+    }
+    m += dims[1];
+    if (every_image>=0) {
+      if (every_image==0)
+	particles_data.image = h5md_create_fixed_data_strided(particles_data.group, "image", 2, dims, H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, dump_fixed, m, size_one);
+      m += dims[1];
+    }
+  }
+  if (every_velocity>=0) {
+    if (every_velocity==0)
+      particles_data.velocity = h5md_create_fixed_data_strided(particles_data.group, "velocity", 2, dims, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, dump_fixed, m, size_one);
+    m += dims[1];
   }
-  if (every_velocity==0)
-    particles_data.velocity = h5md_create_fixed_data_simple(particles_data.group, "velocity", 2, dims, H5T_NATIVE_DOUBLE, dump_velocity);
-  if (every_force==0)
-    particles_data.force = h5md_create_fixed_data_simple(particles_data.group, "force", 2, dims, H5T_NATIVE_DOUBLE, dump_force);
-  if (every_species==0)
-    particles_data.species = h5md_create_fixed_data_simple(particles_data.group, "species", 1, dims, H5T_NATIVE_INT, dump_species);
-  if (every_charge==0) {
-    particles_data.charge = h5md_create_fixed_data_simple(particles_data.group, "charge", 1, dims, H5T_NATIVE_INT, dump_charge);
-    h5md_write_string_attribute(particles_data.group, "charge", "type", "effective");
+  if (every_force>=0) {
+    if (every_force==0)
+      particles_data.force = h5md_create_fixed_data_strided(particles_data.group, "force", 2, dims, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, dump_fixed, m, size_one);
+    m += dims[1];
+  }
+  if (every_species>=0) {
+    if (every_species==0)
+      particles_data.species = h5md_create_fixed_data_strided(particles_data.group, "species", 1, dims, H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, dump_fixed, m, size_one);
+    m += 1;
+  }
+  if (every_charge>=0) {
+    if (every_charge==0) {
+      particles_data.charge = h5md_create_fixed_data_strided(particles_data.group, "charge", 1, dims, H5T_NATIVE_INT, H5T_NATIVE_DOUBLE, dump_fixed, m, size_one);
+      h5md_write_string_attribute(particles_data.group, "charge", "type", "effective");
+    }
+    m += 1;
   }
 
   for (int i=0; i<3; i++) {
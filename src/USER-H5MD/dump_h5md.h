@@ -34,34 +34,33 @@ class DumpH5MD : public Dump {
  private:
   int natoms,ntotal;
   int unwrap_flag;            // 1 if atom coords are unwrapped, 0 if no
+  int nchoose;                // # of selected atoms this snapshot
+  int maxlocal;               // size of atom selection list
+  int *clist;                 // indices of local atoms in dump group
   h5md_file datafile;
   int datafile_from_dump;
   h5md_particles_group particles_data;
   char *author_name;
+  int align_bytes;            // HDF5 chunk/alignment target, 0 if unset
+  int deflate_level;          // gzip level for dataset filters, 0 if unset
 
   bool do_box;
   bool create_group;
+  bool frame_extended;        // current frame extended but not complete
 
-  // data arrays and intervals
+  // data elements and their dump intervals
   int every_dump;
-  double *dump_position;
-  int every_position;
-  int *dump_image;
-  int every_image;
-  double *dump_velocity;
-  int every_velocity;
-  double *dump_force;
-  int every_force;
-  int *dump_species;
-  int every_species;
-  int *dump_charge;
-  int every_charge;
+  int every_position,every_image;
+  int every_velocity,every_force;
+  int every_species,every_charge;
+  double *dump_fixed;         // packed staging block for every = 0 elements
 
   void init_style();
   int modify_param(int, char **);
   void openfile();
   void write_header(bigint);
   void pack(tagint *);
+  template <int DIM> void pack_impl(tagint *);
   void write_data(int, double *);
 
   void write_frame();
@@ -40,6 +40,7 @@ PairCoulDiel::~PairCoulDiel()
   if (allocated) {
     memory->destroy(setflag);
     memory->destroy(sigmae);
+    memory->destroy(sigmaeinv);
     memory->destroy(rme);
     memory->destroy(offset);
     memory->destroy(cutsq);
@@ -101,10 +102,10 @@ void PairCoulDiel::compute(int eflag, int vflag)
 
       if (rsq < cutsq[itype][jtype]) {
         r = sqrt(rsq);
-        rarg = (r-rme[itype][jtype])/sigmae[itype][jtype];
+        rarg = (r-rme[itype][jtype])*sigmaeinv[itype][jtype];
         th=tanh(rarg);
         epsr=a_eps+b_eps*th;
-        depsdr=b_eps * (1.0 - th*th) / sigmae[itype][jtype];
+        depsdr=b_eps * (1.0 - th*th) * sigmaeinv[itype][jtype];
 
         forcecoul = qqrd2e*qtmp*q[j]*((eps_s*(epsr+r*depsdr)/epsr/epsr) -1.)/rsq;
         fpair = factor_coul*forcecoul/r;
@@ -149,6 +150,7 @@ void PairCoulDiel::allocate()
   memory->create(cutsq,n+1,n+1,"pair:cutsq");
   memory->create(cut,n+1,n+1,"pair:cut");
   memory->create(sigmae,n+1,n+1,"pair:sigmae");
+  memory->create(sigmaeinv,n+1,n+1,"pair:sigmaeinv");
   memory->create(rme,n+1,n+1,"pair:rme");
   memory->create(offset,n+1,n+1,"pair:offset");
 }
@@ -242,7 +244,10 @@ double PairCoulDiel::init_one(int i, int j)
   } else offset[i][j] = 0.0;
 
 
+  sigmaeinv[i][j] = 1.0/sigmae[i][j];
+
   sigmae[j][i] = sigmae[i][j];
+  sigmaeinv[j][i] = sigmaeinv[i][j];
   rme[j][i] = rme[i][j];
   offset[j][i] = offset[i][j];
   cut[j][i] = cut[i][j];
@@ -329,20 +334,23 @@ double PairCoulDiel::single(int i, int j, int itype, int jtype,
                            double rsq, double factor_coul, double factor_lj,
                            double &fforce)
 {
-  double r, rarg,forcedielec,phidielec;
-  double th,epsr,depsdr;
+  double r,rinv,r2inv,rarg,forcedielec,phidielec;
+  double th,epsr,epsrinv,depsdr;
   double *q = atom->q;
   double qqrd2e = force->qqrd2e;
 
   r=sqrt(rsq);
-  rarg = (r-rme[itype][jtype])/sigmae[itype][jtype];
+  rinv = 1.0/r;
+  r2inv = rinv*rinv;
+  rarg = (r-rme[itype][jtype])*sigmaeinv[itype][jtype];
   th = tanh(rarg);
   epsr=a_eps+b_eps*th;
-  depsdr=b_eps*(1.-th*th)/sigmae[itype][jtype];
+  epsrinv = 1.0/epsr;
+  depsdr=b_eps*(1.-th*th)*sigmaeinv[itype][jtype];
 
-  forcedielec = qqrd2e*q[i]*q[j]*((eps_s*(epsr+r*depsdr)/epsr/epsr) -1.)/rsq;
-  fforce = factor_coul*forcedielec/r;
+  forcedielec = qqrd2e*q[i]*q[j]*((eps_s*(epsr+r*depsdr)*epsrinv*epsrinv) -1.)*r2inv;
+  fforce = factor_coul*forcedielec*rinv;
 
-  phidielec = (qqrd2e*q[i]*q[j]*((eps_s/epsr) -1.)/r)- offset[itype][jtype];
+  phidielec = (qqrd2e*q[i]*q[j]*((eps_s*epsrinv) -1.)*rinv)- offset[itype][jtype];
   return factor_coul*phidielec;
 }
@@ -46,6 +46,7 @@ class PairCoulDiel : public Pair {
   double cut_global;
   double **cut;
   double **sigmae, **rme, **offset;
+  double **sigmaeinv;         // precomputed 1/sigmae for the hot loop
   double a_eps, b_eps, eps_s;
 
   void allocate();
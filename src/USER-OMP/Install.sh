@@ -41,6 +41,7 @@ for file in *_omp.h; do
   action $file $dep
 done
 
+action thr_chunk.h
 action thr_omp.h
 action thr_omp.cpp
 action thr_data.h
@@ -36,6 +36,16 @@ PairAGNIOMP::PairAGNIOMP(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::OMP;
   respa_enable = 0;
+
+  vscratch = NULL;
+  maxscratch = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+PairAGNIOMP::~PairAGNIOMP()
+{
+  memory->destroy(vscratch);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -50,13 +60,35 @@ void PairAGNIOMP::compute(int eflag, int vflag)
   const int nthreads = comm->nthreads;
   const int inum = list->inum;
 
+  // grow the pooled per-thread scratch for the fingerprint vectors
+  // once instead of allocating three arrays per atom inside eval()
+
+  int maxeta = 0;
+  for (int n = 0; n < nparams; ++n)
+    if (params[n].numeta > maxeta) maxeta = params[n].numeta;
+
+  int grown = 0;
+  if (3*maxeta > maxscratch) {
+    maxscratch = 3*maxeta;
+    memory->destroy(vscratch);
+    memory->create(vscratch,nthreads*maxscratch,"pair:vscratch");
+    grown = 1;
+  }
+
 #if defined(_OPENMP)
-#pragma omp parallel default(none) shared(eflag,vflag)
+#pragma omp parallel default(none) shared(eflag,vflag,grown)
 #endif
   {
     int ifrom, ito, tid;
 
     loop_setup_thr(ifrom, ito, tid, inum, nthreads);
+
+    // first-touch a freshly grown scratch pool: each thread faults in
+    // the pages of its own slice so they are placed on the NUMA node
+    // that will use them, instead of wherever the allocating thread ran
+
+    if (grown)
+      memset(vscratch + tid*maxscratch, 0, maxscratch*sizeof(double));
     ThrData *thr = fix->get_thr(tid);
     thr->timer(Timer::START);
     ev_setup_thr(eflag, vflag, nall, eatom, vatom, thr);
@@ -86,7 +118,12 @@ void PairAGNIOMP::eval(int iifrom, int iito, ThrData * const thr)
   firstneigh = list->firstneigh;
 
   double fxtmp,fytmp,fztmp;
-  double *Vx, *Vy, *Vz;
+
+  // each thread works on its own slice of the pooled scratch block
+
+  double * const Vx = vscratch + thr->get_tid()*maxscratch;
+  double * const Vy = Vx + maxscratch/3;
+  double * const Vz = Vy + maxscratch/3;
 
   // loop over full neighbor list of my atoms
 
@@ -100,9 +137,6 @@ void PairAGNIOMP::eval(int iifrom, int iito, ThrData * const thr)
     fxtmp = fytmp = fztmp = 0.0;
 
     const Param &iparam = params[elem2param[itype]];
-    Vx = new double[iparam.numeta];
-    Vy = new double[iparam.numeta];
-    Vz = new double[iparam.numeta];
     memset(Vx,0,iparam.numeta*sizeof(double));
     memset(Vy,0,iparam.numeta*sizeof(double));
     memset(Vz,0,iparam.numeta*sizeof(double));
@@ -161,9 +195,6 @@ void PairAGNIOMP::eval(int iifrom, int iito, ThrData * const thr)
     if (EVFLAG) ev_tally_xyz_full_thr(this,i,0.0,0.0,
                                       fxtmp,fytmp,fztmp,
                                       delx,dely,delz,thr);
-    delete [] Vx;
-    delete [] Vy;
-    delete [] Vz;
   }
 }
 
@@ -172,6 +203,7 @@ void PairAGNIOMP::eval(int iifrom, int iito, ThrData * const thr)
 double PairAGNIOMP::memory_usage()
 {
   double bytes = memory_usage_thr();
+  bytes += comm->nthreads*maxscratch*sizeof(double);
   bytes += PairAGNI::memory_usage();
 
   return bytes;
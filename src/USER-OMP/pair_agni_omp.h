@@ -33,11 +33,15 @@ class PairAGNIOMP : public PairAGNI, public ThrOMP {
 
  public:
   PairAGNIOMP(class LAMMPS *);
+  virtual ~PairAGNIOMP();
 
   virtual void compute(int, int);
   virtual double memory_usage();
 
  private:
+  double *vscratch;       // pooled per-thread descriptor scratch
+  int maxscratch;         // allocated doubles per thread
+
   template <int EVFLAG>
   void eval(int ifrom, int ito, ThrData * const thr);
 };
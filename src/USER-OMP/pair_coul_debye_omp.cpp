@@ -19,10 +19,23 @@
 #include "force.h"
 #include "neighbor.h"
 #include "neigh_list.h"
+#include "memory.h"
 
 #include "suffix.h"
+#include "thr_chunk.h"
 using namespace LAMMPS_NS;
 
+// staging chunk for surviving neighbors: SoA arrays grouped into one
+// contiguous block so a whole chunk stays resident in L1
+
+struct ChunkCoulDebye {
+  int j[PAIR_CHUNK];
+  double delx[PAIR_CHUNK],dely[PAIR_CHUNK],delz[PAIR_CHUNK];
+  double rsq[PAIR_CHUNK],qj[PAIR_CHUNK];
+  double r[PAIR_CHUNK],screen[PAIR_CHUNK];
+  double fpair[PAIR_CHUNK],e[PAIR_CHUNK];
+};
+
 /* ---------------------------------------------------------------------- */
 
 PairCoulDebyeOMP::PairCoulDebyeOMP(LAMMPS *lmp) :
@@ -30,6 +43,16 @@ PairCoulDebyeOMP::PairCoulDebyeOMP(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::OMP;
   respa_enable = 0;
+
+  jsortbuf = NULL;
+  maxjsort = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+PairCoulDebyeOMP::~PairCoulDebyeOMP()
+{
+  memory->destroy(jsortbuf);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -44,6 +67,32 @@ void PairCoulDebyeOMP::compute(int eflag, int vflag)
   const int nthreads = comm->nthreads;
   const int inum = list->inum;
 
+  // on rebuild steps group each neighbor sublist by atom type so the
+  // parameter gathers in eval() stream through type-homogeneous runs
+
+  if (atom->ntypes > 1 && neighbor->ago == 0) {
+    const int * const type = atom->type;
+    const int * const ilist = list->ilist;
+    const int * const numneigh = list->numneigh;
+    int ** const firstneigh = list->firstneigh;
+
+    int maxneigh = 0;
+    for (int ii = 0; ii < inum; ++ii)
+      if (numneigh[ilist[ii]] > maxneigh) maxneigh = numneigh[ilist[ii]];
+
+    if (maxneigh > maxjsort) {
+      maxjsort = maxneigh;
+      memory->destroy(jsortbuf);
+      memory->create(jsortbuf,maxjsort,"pair:jsortbuf");
+    }
+
+    for (int ii = 0; ii < inum; ++ii) {
+      const int i = ilist[ii];
+      sort_jlist_by_type(firstneigh[i],numneigh[i],atom->ntypes,type,
+                         jsortbuf);
+    }
+  }
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none) shared(eflag,vflag)
 #endif
@@ -55,17 +104,35 @@ void PairCoulDebyeOMP::compute(int eflag, int vflag)
     thr->timer(Timer::START);
     ev_setup_thr(eflag, vflag, nall, eatom, vatom, thr);
 
-    if (evflag) {
-      if (eflag) {
-        if (force->newton_pair) eval<1,1,1>(ifrom, ito, thr);
-        else eval<1,1,0>(ifrom, ito, thr);
+    // single-type systems get a specialized instantiation with the
+    // type-pair table lookups folded into hoisted scalars
+
+    if (atom->ntypes == 1) {
+      if (evflag) {
+        if (eflag) {
+          if (force->newton_pair) eval<1,1,1,1>(ifrom, ito, thr);
+          else eval<1,1,0,1>(ifrom, ito, thr);
+        } else {
+          if (force->newton_pair) eval<1,0,1,1>(ifrom, ito, thr);
+          else eval<1,0,0,1>(ifrom, ito, thr);
+        }
       } else {
-        if (force->newton_pair) eval<1,0,1>(ifrom, ito, thr);
-        else eval<1,0,0>(ifrom, ito, thr);
+        if (force->newton_pair) eval<0,0,1,1>(ifrom, ito, thr);
+        else eval<0,0,0,1>(ifrom, ito, thr);
       }
     } else {
-      if (force->newton_pair) eval<0,0,1>(ifrom, ito, thr);
-      else eval<0,0,0>(ifrom, ito, thr);
+      if (evflag) {
+        if (eflag) {
+          if (force->newton_pair) eval<1,1,1,0>(ifrom, ito, thr);
+          else eval<1,1,0,0>(ifrom, ito, thr);
+        } else {
+          if (force->newton_pair) eval<1,0,1,0>(ifrom, ito, thr);
+          else eval<1,0,0,0>(ifrom, ito, thr);
+        }
+      } else {
+        if (force->newton_pair) eval<0,0,1,0>(ifrom, ito, thr);
+        else eval<0,0,0,0>(ifrom, ito, thr);
+      }
     }
 
     thr->timer(Timer::PAIR);
@@ -75,14 +142,19 @@ void PairCoulDebyeOMP::compute(int eflag, int vflag)
 
 /* ---------------------------------------------------------------------- */
 
-template <int EVFLAG, int EFLAG, int NEWTON_PAIR>
+template <int EVFLAG, int EFLAG, int NEWTON_PAIR, int ONETYPE>
 void PairCoulDebyeOMP::eval(int iifrom, int iito, ThrData * const thr)
 {
-  int i,j,ii,jj,jnum,itype,jtype;
+  int i,j,ii,jj,kk,jnum,itype,jtype;
   double qtmp,xtmp,ytmp,ztmp,delx,dely,delz,ecoul,fpair;
-  double rsq,r2inv,r,rinv,forcecoul,factor_coul,screening;
+  double rsq,r2inv,r,rinv,forcecoul,screening;
   int *ilist,*jlist,*numneigh,**firstneigh;
 
+  // staging chunk for neighbors that pass the cutoff test, aligned
+  // to the cache line/vector register width
+
+  _alignvar(ChunkCoulDebye cbuf,64);
+
   ecoul = 0.0;
 
   const dbl3_t * _noalias const x = (dbl3_t *) atom->x[0];
@@ -94,6 +166,11 @@ void PairCoulDebyeOMP::eval(int iifrom, int iito, ThrData * const thr)
   const double qqrd2e = force->qqrd2e;
   double fxtmp,fytmp,fztmp;
 
+  // with a single atom type the cutoff table collapses to one scalar
+  // that lives in a register for the whole kernel
+
+  const double cutsq_11 = ONETYPE ? cutsq[1][1] : 0.0;
+
   ilist = list->ilist;
   numneigh = list->numneigh;
   firstneigh = list->firstneigh;
@@ -112,39 +189,88 @@ void PairCoulDebyeOMP::eval(int iifrom, int iito, ThrData * const thr)
     jnum = numneigh[i];
     fxtmp=fytmp=fztmp=0.0;
 
-    for (jj = 0; jj < jnum; jj++) {
-      j = jlist[jj];
-      factor_coul = special_coul[sbmask(j)];
-      j &= NEIGHMASK;
+    // hoist the cutoff table row of atom i
+
+    const double * _noalias const cutsq_i = cutsq[itype];
+
+    for (jj = 0; jj < jnum; jj += PAIR_CHUNK) {
+      const int jend = MIN(jj+PAIR_CHUNK,jnum);
+      int nacc = 0;
+
+      // pass 1: apply the cutoff filter and gather surviving neighbors
+      // into dense staging buffers
+
+      for (kk = jj; kk < jend; kk++) {
+        j = jlist[kk];
+        const double factor_coul = special_coul[sbmask(j)];
+        j &= NEIGHMASK;
+
+        delx = xtmp - x[j].x;
+        dely = ytmp - x[j].y;
+        delz = ztmp - x[j].z;
+        rsq = delx*delx + dely*dely + delz*delz;
+        if (!ONETYPE) jtype = type[j];
+
+        if (rsq < (ONETYPE ? cutsq_11 : cutsq_i[jtype])) {
+          cbuf.j[nacc] = j;
+          cbuf.delx[nacc] = delx;
+          cbuf.dely[nacc] = dely;
+          cbuf.delz[nacc] = delz;
+          cbuf.rsq[nacc] = rsq;
+          // the special-bond factor scales force and energy alike, so
+          // fold it into the gathered charge once instead of carrying
+          // it through the compute passes
+          cbuf.qj[nacc] = factor_coul*q[j];
+          ++nacc;
+        }
+      }
+
+      // pass 2a: batched transcendentals. keeping the exp calls in a
+      // loop of their own lets the compiler replace them with the
+      // vector math library variant (libmvec/SVML) over the whole batch.
+
+      LMP_OMP_SIMD
+      for (kk = 0; kk < nacc; kk++) {
+        cbuf.r[kk] = sqrt(cbuf.rsq[kk]);
+        cbuf.screen[kk] = exp(-kappa*cbuf.r[kk]);
+      }
 
-      delx = xtmp - x[j].x;
-      dely = ytmp - x[j].y;
-      delz = ztmp - x[j].z;
-      rsq = delx*delx + dely*dely + delz*delz;
-      jtype = type[j];
+      // pass 2b: force/energy kernel from the precomputed screening
 
-      if (rsq < cutsq[itype][jtype]) {
-        r2inv = 1.0/rsq;
-        r = sqrt(rsq);
+      LMP_OMP_SIMD
+      for (kk = 0; kk < nacc; kk++) {
+        // one reciprocal per neighbor: the inverse square comes from a
+        // multiply instead of a second division
+        r = cbuf.r[kk];
         rinv = 1.0/r;
-        screening = exp(-kappa*r);
-        forcecoul = qqrd2e * qtmp*q[j] * screening * (kappa + rinv);
-        fpair = factor_coul*forcecoul * r2inv;
+        r2inv = rinv*rinv;
+        screening = cbuf.screen[kk];
+        forcecoul = qqrd2e * qtmp*cbuf.qj[kk] * screening * (kappa + rinv);
+        cbuf.fpair[kk] = forcecoul * r2inv;
+        if (EFLAG)
+          cbuf.e[kk] = qqrd2e * qtmp*cbuf.qj[kk] * rinv * screening;
+      }
+
+      // pass 3: scatter forces back to the thread-local array
 
-        fxtmp += delx*fpair;
-        fytmp += dely*fpair;
-        fztmp += delz*fpair;
+      for (kk = 0; kk < nacc; kk++) {
+        j = cbuf.j[kk];
+        fpair = cbuf.fpair[kk];
+
+        fxtmp += cbuf.delx[kk]*fpair;
+        fytmp += cbuf.dely[kk]*fpair;
+        fztmp += cbuf.delz[kk]*fpair;
         if (NEWTON_PAIR || j < nlocal) {
-          f[j].x -= delx*fpair;
-          f[j].y -= dely*fpair;
-          f[j].z -= delz*fpair;
+          f[j].x -= cbuf.delx[kk]*fpair;
+          f[j].y -= cbuf.dely[kk]*fpair;
+          f[j].z -= cbuf.delz[kk]*fpair;
         }
 
-        if (EFLAG)
-          ecoul = factor_coul * qqrd2e * qtmp*q[j] * rinv * screening;
+        if (EFLAG) ecoul = cbuf.e[kk];
 
         if (EVFLAG) ev_tally_thr(this, i,j,nlocal,NEWTON_PAIR,
-                                 0.0,ecoul,fpair,delx,dely,delz,thr);
+                                 0.0,ecoul,fpair,cbuf.delx[kk],
+                                 cbuf.dely[kk],cbuf.delz[kk],thr);
       }
     }
     f[i].x += fxtmp;
@@ -157,6 +283,7 @@ void PairCoulDebyeOMP::eval(int iifrom, int iito, ThrData * const thr)
 double PairCoulDebyeOMP::memory_usage()
 {
   double bytes = memory_usage_thr();
+  bytes += maxjsort*sizeof(int);
   bytes += PairCoulDebye::memory_usage();
 
   return bytes;
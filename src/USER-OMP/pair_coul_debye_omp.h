@@ -33,12 +33,16 @@ class PairCoulDebyeOMP : public PairCoulDebye, public ThrOMP {
 
  public:
   PairCoulDebyeOMP(class LAMMPS *);
+  virtual ~PairCoulDebyeOMP();
 
   virtual void compute(int, int);
   virtual double memory_usage();
 
  private:
-  template <int EVFLAG, int EFLAG, int NEWTON_PAIR>
+  int *jsortbuf;          // scratch for type-grouping neighbor lists
+  int maxjsort;           // allocated size of jsortbuf
+
+  template <int EVFLAG, int EFLAG, int NEWTON_PAIR, int ONETYPE>
   void eval(int ifrom, int ito, ThrData * const thr);
 };
 
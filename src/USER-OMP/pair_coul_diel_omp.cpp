@@ -19,10 +19,25 @@
 #include "force.h"
 #include "neighbor.h"
 #include "neigh_list.h"
+#include "memory.h"
 
 #include "suffix.h"
+#include "thr_chunk.h"
 using namespace LAMMPS_NS;
 
+// staging chunk for surviving neighbors and their pair parameters:
+// SoA arrays grouped into one contiguous block so a whole chunk stays
+// resident in L1
+
+struct ChunkCoulDiel {
+  int j[PAIR_CHUNK];
+  double delx[PAIR_CHUNK],dely[PAIR_CHUNK],delz[PAIR_CHUNK];
+  double rsq[PAIR_CHUNK],qj[PAIR_CHUNK];
+  double rme[PAIR_CHUNK],sigmaeinv[PAIR_CHUNK],offset[PAIR_CHUNK];
+  double r[PAIR_CHUNK],th[PAIR_CHUNK];
+  double fpair[PAIR_CHUNK],e[PAIR_CHUNK];
+};
+
 /* ---------------------------------------------------------------------- */
 
 PairCoulDielOMP::PairCoulDielOMP(LAMMPS *lmp) :
@@ -30,6 +45,19 @@ PairCoulDielOMP::PairCoulDielOMP(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::OMP;
   respa_enable = 0;
+
+  jsortbuf = NULL;
+  maxjsort = 0;
+  flatparam = NULL;
+  maxflat = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+PairCoulDielOMP::~PairCoulDielOMP()
+{
+  memory->destroy(jsortbuf);
+  memory->destroy(flatparam);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -44,6 +72,54 @@ void PairCoulDielOMP::compute(int eflag, int vflag)
   const int nthreads = comm->nthreads;
   const int inum = list->inum;
 
+  // on rebuild steps group each neighbor sublist by atom type so the
+  // parameter gathers in eval() stream through type-homogeneous runs
+
+  if (atom->ntypes > 1 && neighbor->ago == 0) {
+    const int * const type = atom->type;
+    const int * const ilist = list->ilist;
+    const int * const numneigh = list->numneigh;
+    int ** const firstneigh = list->firstneigh;
+
+    int maxneigh = 0;
+    for (int ii = 0; ii < inum; ++ii)
+      if (numneigh[ilist[ii]] > maxneigh) maxneigh = numneigh[ilist[ii]];
+
+    if (maxneigh > maxjsort) {
+      maxjsort = maxneigh;
+      memory->destroy(jsortbuf);
+      memory->create(jsortbuf,maxjsort,"pair:jsortbuf");
+    }
+
+    for (int ii = 0; ii < inum; ++ii) {
+      const int i = ilist[ii];
+      sort_jlist_by_type(firstneigh[i],numneigh[i],atom->ntypes,type,
+                         jsortbuf);
+    }
+  }
+
+  // repack the four ragged double** tables into one flat block of
+  // 4-double records keyed by itype*(ntypes+1)+jtype, as in the OPT
+  // package: the gather pass in eval() then reads all parameters of a
+  // neighbor with one contiguous load instead of walking four tables
+
+  if (atom->ntypes > 1) {
+    const int ntp1 = atom->ntypes + 1;
+    if (4*ntp1*ntp1 > maxflat) {
+      maxflat = 4*ntp1*ntp1;
+      memory->destroy(flatparam);
+      memory->create(flatparam,maxflat,"pair:flatparam");
+    }
+    for (int i = 1; i <= atom->ntypes; ++i)
+      for (int j = 1; j <= atom->ntypes; ++j) {
+        double * const p = flatparam + 4*(i*ntp1+j);
+        p[0] = cutsq[i][j];
+        p[1] = rme[i][j];
+        p[2] = sigmaeinv[i][j];
+        p[3] = offset[i][j];
+      }
+  }
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none) shared(eflag,vflag)
 #endif
@@ -55,17 +131,35 @@ void PairCoulDielOMP::compute(int eflag, int vflag)
     thr->timer(Timer::START);
     ev_setup_thr(eflag, vflag, nall, eatom, vatom, thr);
 
-    if (evflag) {
-      if (eflag) {
-        if (force->newton_pair) eval<1,1,1>(ifrom, ito, thr);
-        else eval<1,1,0>(ifrom, ito, thr);
+    // single-type systems get a specialized instantiation with the
+    // type-pair table lookups folded into hoisted scalars
+
+    if (atom->ntypes == 1) {
+      if (evflag) {
+        if (eflag) {
+          if (force->newton_pair) eval<1,1,1,1>(ifrom, ito, thr);
+          else eval<1,1,0,1>(ifrom, ito, thr);
+        } else {
+          if (force->newton_pair) eval<1,0,1,1>(ifrom, ito, thr);
+          else eval<1,0,0,1>(ifrom, ito, thr);
+        }
       } else {
-        if (force->newton_pair) eval<1,0,1>(ifrom, ito, thr);
-        else eval<1,0,0>(ifrom, ito, thr);
+        if (force->newton_pair) eval<0,0,1,1>(ifrom, ito, thr);
+        else eval<0,0,0,1>(ifrom, ito, thr);
       }
     } else {
-      if (force->newton_pair) eval<0,0,1>(ifrom, ito, thr);
-      else eval<0,0,0>(ifrom, ito, thr);
+      if (evflag) {
+        if (eflag) {
+          if (force->newton_pair) eval<1,1,1,0>(ifrom, ito, thr);
+          else eval<1,1,0,0>(ifrom, ito, thr);
+        } else {
+          if (force->newton_pair) eval<1,0,1,0>(ifrom, ito, thr);
+          else eval<1,0,0,0>(ifrom, ito, thr);
+        }
+      } else {
+        if (force->newton_pair) eval<0,0,1,0>(ifrom, ito, thr);
+        else eval<0,0,0,0>(ifrom, ito, thr);
+      }
     }
 
     thr->timer(Timer::PAIR);
@@ -75,14 +169,19 @@ void PairCoulDielOMP::compute(int eflag, int vflag)
 
 /* ---------------------------------------------------------------------- */
 
-template <int EVFLAG, int EFLAG, int NEWTON_PAIR>
+template <int EVFLAG, int EFLAG, int NEWTON_PAIR, int ONETYPE>
 void PairCoulDielOMP::eval(int iifrom, int iito, ThrData * const thr)
 {
-  int i,j,ii,jj,jnum,itype,jtype;
+  int i,j,ii,jj,kk,jnum,itype,jtype;
   double qtmp,xtmp,ytmp,ztmp,delx,dely,delz,ecoul,fpair;
-  double rsq,r,rarg,th,depsdr,epsr,forcecoul,factor_coul;
+  double rsq,r,rarg,th,depsdr,epsr,forcecoul;
   int *ilist,*jlist,*numneigh,**firstneigh;
 
+  // staging chunk for neighbors that pass the cutoff test, aligned
+  // to the cache line/vector register width
+
+  _alignvar(ChunkCoulDiel cbuf,64);
+
   ecoul = 0.0;
 
   const dbl3_t * _noalias const x = (dbl3_t *) atom->x[0];
@@ -90,10 +189,19 @@ void PairCoulDielOMP::eval(int iifrom, int iito, ThrData * const thr)
   const double * _noalias const q = atom->q;
   const int * _noalias const type = atom->type;
   const int nlocal = atom->nlocal;
+  const int ntypes = atom->ntypes;
   const double * _noalias const special_coul = force->special_coul;
   const double qqrd2e = force->qqrd2e;
   double fxtmp,fytmp,fztmp;
 
+  // with a single atom type the parameter tables collapse to scalars
+  // that live in registers for the whole kernel
+
+  const double cutsq_11 = ONETYPE ? cutsq[1][1] : 0.0;
+  const double rme_11 = ONETYPE ? rme[1][1] : 0.0;
+  const double sigmaeinv_11 = ONETYPE ? sigmaeinv[1][1] : 0.0;
+  const double offset_11 = ONETYPE ? offset[1][1] : 0.0;
+
   ilist = list->ilist;
   numneigh = list->numneigh;
   firstneigh = list->firstneigh;
@@ -112,44 +220,108 @@ void PairCoulDielOMP::eval(int iifrom, int iito, ThrData * const thr)
     jnum = numneigh[i];
     fxtmp=fytmp=fztmp=0.0;
 
-    for (jj = 0; jj < jnum; jj++) {
-      j = jlist[jj];
+    // hoist atom i's row of the flat parameter block: each surviving
+    // neighbor then fetches its whole 4-double record from one place
+
+    const double * _noalias const param_i =
+      ONETYPE ? (const double *) NULL : flatparam + 4*itype*(ntypes+1);
+
+    for (jj = 0; jj < jnum; jj += PAIR_CHUNK) {
+      const int jend = MIN(jj+PAIR_CHUNK,jnum);
+      int nacc = 0;
+
+      // pass 1: apply the cutoff filter and gather surviving neighbors
+      // and their pair parameters into dense staging buffers
+
+      for (kk = jj; kk < jend; kk++) {
+        j = jlist[kk];
+        const double factor_coul = special_coul[sbmask(j)];
+        j &= NEIGHMASK;
+
+        delx = xtmp - x[j].x;
+        dely = ytmp - x[j].y;
+        delz = ztmp - x[j].z;
+        rsq = delx*delx + dely*dely + delz*delz;
+        if (!ONETYPE) jtype = type[j];
+        const double * _noalias const pp =
+          ONETYPE ? (const double *) NULL : param_i + 4*jtype;
+
+        if (rsq < (ONETYPE ? cutsq_11 : pp[0])) {
+          cbuf.j[nacc] = j;
+          cbuf.delx[nacc] = delx;
+          cbuf.dely[nacc] = dely;
+          cbuf.delz[nacc] = delz;
+          cbuf.rsq[nacc] = rsq;
+          // the special-bond factor scales force and energy alike, so
+          // fold it into the gathered charge (and the energy offset)
+          // once instead of carrying it through the compute passes
+          cbuf.qj[nacc] = factor_coul*q[j];
+          if (!ONETYPE) {
+            cbuf.rme[nacc] = pp[1];
+            cbuf.sigmaeinv[nacc] = pp[2];
+          }
+          if (EFLAG)
+            cbuf.offset[nacc] =
+              factor_coul*(ONETYPE ? offset_11 : pp[3]);
+          ++nacc;
+        }
+      }
 
-      factor_coul = special_coul[sbmask(j)];
-      j &= NEIGHMASK;
+      // pass 2a: batched transcendentals. tanh is evaluated through the
+      // identity tanh(x) = 1 - 2/(exp(2x)+1) so the batch reduces to a
+      // single vectorizable exp; libm tanh has no vector counterpart and
+      // would serialize the loop.
+
+      LMP_OMP_SIMD
+      for (kk = 0; kk < nacc; kk++) {
+        r = sqrt(cbuf.rsq[kk]);
+        cbuf.r[kk] = r;
+        rarg = (r-(ONETYPE ? rme_11 : cbuf.rme[kk]))
+          * (ONETYPE ? sigmaeinv_11 : cbuf.sigmaeinv[kk]);
+        cbuf.th[kk] = 1.0 - 2.0/(exp(2.0*rarg)+1.0);
+      }
 
-      delx = xtmp - x[j].x;
-      dely = ytmp - x[j].y;
-      delz = ztmp - x[j].z;
-      rsq = delx*delx + dely*dely + delz*delz;
-      jtype = type[j];
+      // pass 2b: branch-free force/energy kernel over the dense batch
 
-      if (rsq < cutsq[itype][jtype]) {
-        r = sqrt(rsq);
-        rarg = (r-rme[itype][jtype])/sigmae[itype][jtype];
-        th=tanh(rarg);
+      LMP_OMP_SIMD
+      for (kk = 0; kk < nacc; kk++) {
+        r = cbuf.r[kk];
+        th = cbuf.th[kk];
+        // one reciprocal each for r and epsr; all other inverse powers
+        // come from multiplies instead of further divisions
+        const double rinv = 1.0/r;
+        const double r2inv = rinv*rinv;
         epsr=a_eps+b_eps*th;
-        depsdr=b_eps * (1.0 - th*th) / sigmae[itype][jtype];
+        const double epsrinv = 1.0/epsr;
+        depsdr=b_eps * (1.0 - th*th) * (ONETYPE ? sigmaeinv_11 : cbuf.sigmaeinv[kk]);
 
-        forcecoul = qqrd2e*qtmp*q[j]*((eps_s*(epsr+r*depsdr)/epsr/epsr) -1.)/rsq;
-        fpair = factor_coul*forcecoul/r;
+        forcecoul = qqrd2e*qtmp*cbuf.qj[kk]*((eps_s*(epsr+r*depsdr)*epsrinv*epsrinv) -1.)*r2inv;
+        cbuf.fpair[kk] = forcecoul*rinv;
 
-        fxtmp += delx*fpair;
-        fytmp += dely*fpair;
-        fztmp += delz*fpair;
+        if (EFLAG)
+          cbuf.e[kk] = (qqrd2e*qtmp*cbuf.qj[kk]*((eps_s*epsrinv) -1.)*rinv) - cbuf.offset[kk];
+      }
+
+      // pass 3: scatter forces back to the thread-local array
+
+      for (kk = 0; kk < nacc; kk++) {
+        j = cbuf.j[kk];
+        fpair = cbuf.fpair[kk];
+
+        fxtmp += cbuf.delx[kk]*fpair;
+        fytmp += cbuf.dely[kk]*fpair;
+        fztmp += cbuf.delz[kk]*fpair;
         if (NEWTON_PAIR || j < nlocal) {
-          f[j].x -= delx*fpair;
-          f[j].y -= dely*fpair;
-          f[j].z -= delz*fpair;
+          f[j].x -= cbuf.delx[kk]*fpair;
+          f[j].y -= cbuf.dely[kk]*fpair;
+          f[j].z -= cbuf.delz[kk]*fpair;
         }
 
-        if (EFLAG) {
-          ecoul = (qqrd2e*qtmp*q[j]*((eps_s/epsr) -1.)/r) - offset[itype][jtype];
-          ecoul *= factor_coul;
-        }
+        if (EFLAG) ecoul = cbuf.e[kk];
 
         if (EVFLAG) ev_tally_thr(this, i,j,nlocal,NEWTON_PAIR,
-                                 0.0,ecoul,fpair,delx,dely,delz,thr);
+                                 0.0,ecoul,fpair,cbuf.delx[kk],
+                                 cbuf.dely[kk],cbuf.delz[kk],thr);
       }
     }
     f[i].x += fxtmp;
@@ -163,6 +335,8 @@ void PairCoulDielOMP::eval(int iifrom, int iito, ThrData * const thr)
 double PairCoulDielOMP::memory_usage()
 {
   double bytes = memory_usage_thr();
+  bytes += maxjsort*sizeof(int);
+  bytes += maxflat*sizeof(double);
   bytes += PairCoulDiel::memory_usage();
 
   return bytes;
@@ -33,12 +33,18 @@ class PairCoulDielOMP : public PairCoulDiel, public ThrOMP {
 
  public:
   PairCoulDielOMP(class LAMMPS *);
+  virtual ~PairCoulDielOMP();
 
   virtual void compute(int, int);
   virtual double memory_usage();
 
  private:
-  template <int EVFLAG, int EFLAG, int NEWTON_PAIR>
+  int *jsortbuf;          // scratch for type-grouping neighbor lists
+  int maxjsort;           // allocated size of jsortbuf
+  double *flatparam;      // flat per-pair block of the parameter tables
+  int maxflat;            // allocated size of flatparam
+
+  template <int EVFLAG, int EFLAG, int NEWTON_PAIR, int ONETYPE>
   void eval(int ifrom, int ito, ThrData * const thr);
 };
 
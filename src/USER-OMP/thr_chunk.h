@@ -0,0 +1,69 @@
+/* -*- c++ -*- -------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_THR_CHUNK_H
+#define LMP_THR_CHUNK_H
+
+// support for chunked (array-of-structure-of-arrays) staging of neighbor
+// data in threaded pair kernels. kernels gather surviving neighbors into
+// fixed-size per-thread chunks and run their force loops over the dense
+// batch, so the hot loops stay branch-free and vectorizable.
+
+// number of neighbors staged per chunk. sized so that a full chunk of
+// staging arrays (up to ~14 doubles per lane in the current kernels,
+// i.e. about 7kB) fits in a 32kB L1 data cache next to the streamed
+// coordinate and neighbor list data.
+
+#define PAIR_CHUNK 64
+
+// request simd vectorization of a dense batch loop where OpenMP 4.0
+// is available; harmless no-op otherwise.
+
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define LMP_OMP_SIMD _Pragma("omp simd")
+#else
+#define LMP_OMP_SIMD
+#endif
+
+#include <string.h>
+#include "lmptype.h"
+
+namespace LAMMPS_NS {
+
+// stable counting sort of one neighbor sublist so that neighbors are
+// grouped by atom type, preserving the special-bond bits encoded in
+// the high bits of each entry. turns the per-type parameter gathers of
+// the chunked kernels into runs of identical loads. temp must hold
+// jnum entries; lists with 256 or more types are left untouched.
+
+inline void sort_jlist_by_type(int * const jlist, const int jnum,
+                               const int ntypes, const int * const type,
+                               int * const temp)
+{
+  int start[258];
+  int kk,t;
+
+  if (ntypes >= 256) return;
+
+  for (t = 0; t <= ntypes+1; t++) start[t] = 0;
+  for (kk = 0; kk < jnum; kk++)
+    ++start[type[jlist[kk] & NEIGHMASK]+1];
+  for (t = 1; t <= ntypes+1; t++) start[t] += start[t-1];
+  for (kk = 0; kk < jnum; kk++)
+    temp[start[type[jlist[kk] & NEIGHMASK]]++] = jlist[kk];
+  memcpy(jlist,temp,jnum*sizeof(int));
+}
+
+}
+
+#endif
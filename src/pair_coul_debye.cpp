@@ -169,9 +169,9 @@ double PairCoulDebye::single(int i, int j, int itype, int jtype,
 {
   double r2inv,r,rinv,forcecoul,phicoul,screening;
 
-  r2inv = 1.0/rsq;
   r = sqrt(rsq);
   rinv = 1.0/r;
+  r2inv = rinv*rinv;
   screening = exp(-kappa*r);
   forcecoul = force->qqrd2e * atom->q[i]*atom->q[j] *
     screening * (kappa + rinv);